@@ -2,11 +2,11 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import pins
 from esphome.const import CONF_ID
-from esphome.components import binary_sensor
+from esphome.components import binary_sensor, text_sensor
 
 CODEOWNERS = ["@pesho"]
 DEPENDENCIES = []
-AUTO_LOAD = []
+AUTO_LOAD = ["text_sensor"]
 
 pesho_somfy_ns = cg.esphome_ns.namespace("pesho_somfy")
 PeshoSomfyComponent = pesho_somfy_ns.class_("PeshoSomfyComponent", cg.Component)
@@ -21,7 +21,9 @@ CONF_LED4_PIN = "led4_pin"
 CONF_LED3_BINARY_SENSOR = "led3_binary_sensor"
 CONF_LED4_BINARY_SENSOR = "led4_binary_sensor"
 CONF_READY_BINARY_SENSOR = "ready_binary_sensor"
+CONF_STATUS_TEXT_SENSOR = "status_text_sensor"
 CONF_BUTTON_PRESS_DURATION = "button_press_duration"
+CONF_LONG_PRESS_DURATION = "long_press_duration"
 
 CONFIG_SCHEMA = cv.Schema(
     {
@@ -35,7 +37,9 @@ CONFIG_SCHEMA = cv.Schema(
         cv.Optional(CONF_LED3_BINARY_SENSOR): cv.use_id(binary_sensor.BinarySensor),
         cv.Optional(CONF_LED4_BINARY_SENSOR): cv.use_id(binary_sensor.BinarySensor),
         cv.Optional(CONF_READY_BINARY_SENSOR): cv.use_id(binary_sensor.BinarySensor),
+        cv.Optional(CONF_STATUS_TEXT_SENSOR): cv.use_id(text_sensor.TextSensor),
         cv.Optional(CONF_BUTTON_PRESS_DURATION, default="500ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_LONG_PRESS_DURATION, default="5s"): cv.positive_time_period_milliseconds,
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
@@ -79,5 +83,13 @@ async def to_code(config):
         ready_sensor = await cg.get_variable(config[CONF_READY_BINARY_SENSOR])
         cg.add(var.set_ready_binary_sensor(ready_sensor))
 
+    # Set status text sensor (optional)
+    if CONF_STATUS_TEXT_SENSOR in config:
+        status_sensor = await cg.get_variable(config[CONF_STATUS_TEXT_SENSOR])
+        cg.add(var.set_status_text_sensor(status_sensor))
+
     # Set button press duration
     cg.add(var.set_button_press_duration(config[CONF_BUTTON_PRESS_DURATION]))
+
+    # Set long press duration (HOLD MY)
+    cg.add(var.set_long_press_duration(config[CONF_LONG_PRESS_DURATION]))
@@ -7,28 +7,53 @@ namespace pesho_somfy {
 
 static const char *const TAG = "pesho_somfy";
 
+// Button names for logging, indexed by RemoteButton
+static constexpr const char *BUTTON_NAMES[NUM_BUTTONS] = {"Select Cover", "Up", "Down", "My"};
+
+// Action -> button dispatch table, indexed by CoverAction
+enum ActionPress : uint8_t {
+  ACTION_PRESS_SHORT,  // One press of button_press_duration
+  ACTION_PRESS_LONG,   // One press of long_press_duration
+  ACTION_PRESS_TRAIN,  // CoverCommand::repeat presses of button_press_duration
+};
+struct CoverActionInfo {
+  uint8_t button_mask;  // Buttons pressed together (bit per RemoteButton)
+  ActionPress press;
+  const char *name;     // Name for logging
+};
+static constexpr CoverActionInfo COVER_ACTION_TABLE[COVER_ACTION_COUNT] = {
+    {0, ACTION_PRESS_SHORT, "NONE"},
+    {1 << BUTTON_UP, ACTION_PRESS_SHORT, "UP"},
+    {1 << BUTTON_DOWN, ACTION_PRESS_SHORT, "DOWN"},
+    {1 << BUTTON_MY, ACTION_PRESS_SHORT, "MY"},
+    {1 << BUTTON_MY, ACTION_PRESS_LONG, "HOLD MY"},
+    {(1 << BUTTON_UP) | (1 << BUTTON_DOWN), ACTION_PRESS_SHORT, "UP+DOWN"},
+    {1 << BUTTON_UP, ACTION_PRESS_TRAIN, "TILT UP"},
+    {1 << BUTTON_DOWN, ACTION_PRESS_TRAIN, "TILT DOWN"},
+};
+static_assert(COVER_ACTION_TABLE[COVER_ACTION_TILT_DOWN].button_mask == (1 << BUTTON_DOWN), 
+              "Action table out of order");
+
 void PeshoSomfyComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up Pesho Somfy Remote Control...");
 
   // Validate required pins
-  if (this->select_cover_pin_ == nullptr || this->up_pin_ == nullptr || 
-      this->down_pin_ == nullptr || this->my_pin_ == nullptr) {
-    ESP_LOGE(TAG, "Required pins not configured!");
-    this->mark_failed();
-    return;
+  for (InternalGPIOPin *pin : this->button_pins_) {
+    if (pin == nullptr) {
+      ESP_LOGE(TAG, "Required pins not configured!");
+      this->mark_failed();
+      return;
+    }
   }
 
   // Configure all button pins as INPUT initially (floating, high impedance)
   // This prevents current from flowing back into the circuit
-  this->select_cover_pin_->pin_mode(gpio::FLAG_INPUT);
-  this->up_pin_->pin_mode(gpio::FLAG_INPUT);
-  this->down_pin_->pin_mode(gpio::FLAG_INPUT);
-  this->my_pin_->pin_mode(gpio::FLAG_INPUT);
-  ESP_LOGCONFIG(TAG, "  Select Cover Pin: GPIO%u", this->select_cover_pin_->get_pin());
-  ESP_LOGCONFIG(TAG, "  Up Pin: GPIO%u", this->up_pin_->get_pin());
-  ESP_LOGCONFIG(TAG, "  Down Pin: GPIO%u", this->down_pin_->get_pin());
-  ESP_LOGCONFIG(TAG, "  My Pin: GPIO%u", this->my_pin_->get_pin());
+  for (uint8_t button = 0; button < NUM_BUTTONS; button++) {
+    this->button_pins_[button]->pin_mode(gpio::FLAG_INPUT);
+    ESP_LOGCONFIG(TAG, "  %s Pin: GPIO%u", BUTTON_NAMES[button], this->button_pins_[button]->get_pin());
+  }
   ESP_LOGCONFIG(TAG, "  Button Press Duration: %u ms", this->button_press_duration_ms_);
+  ESP_LOGCONFIG(TAG, "  Long Press Duration: %u ms", this->long_press_duration_ms_);
 
   // Configure LED pins as INPUT if they are set
   if (this->led3_pin_ != nullptr) {
@@ -48,6 +73,9 @@ void PeshoSomfyComponent::setup() {
   if (this->ready_binary_sensor_ != nullptr) {
     this->ready_binary_sensor_->publish_state(this->is_ready());
   }
+  
+  // Publish initial status to text sensor if linked
+  this->publish_status();
 }
 
 void PeshoSomfyComponent::loop() {
@@ -61,7 +89,7 @@ void PeshoSomfyComponent::loop() {
   }
   
   // Sync cover index from LEDs periodically (but not during select, and not immediately after select)
-  if (this->select_cover_state_ == SELECT_COVER_IDLE &&
+  if (this->select_op_.state == SELECT_COVER_IDLE &&
       now - this->last_led_sync_time_ > LED_SYNC_INTERVAL_MS &&
       now - this->last_select_cover_complete_time_ > LED_SYNC_DELAY_AFTER_SELECT_MS) {
     sync_cover_index_from_leds();
@@ -69,12 +97,15 @@ void PeshoSomfyComponent::loop() {
   }
   
   // Handle select cover state machine
-  if (this->select_cover_state_ != SELECT_COVER_IDLE) {
+  if (this->select_op_.state != SELECT_COVER_IDLE) {
     handle_select_cover_state_machine();
   }
   
-  // Check if button press duration has elapsed and release if needed
-  release_button_if_done();
+  // Start/release scheduled button pulses
+  update_pulse_engine();
+  
+  // Start preempting STOPs and deferred commands once the gap after the last release has passed
+  service_command_queue();
   
   // Track and log ready state changes
   bool current_ready_state = this->is_ready();
@@ -92,88 +123,263 @@ void PeshoSomfyComponent::loop() {
   }
 }
 
-void PeshoSomfyComponent::press_button(InternalGPIOPin *pin, const char *button_name, bool skip_ready_check) {
-  if (pin == nullptr) {
-    ESP_LOGW(TAG, "Attempted to press %s but pin is not configured", button_name);
-    return;
+void PeshoSomfyComponent::press_button(RemoteButton button, const char *button_name, bool skip_ready_check) {
+  this->start_press(1 << button, button_name, this->get_press_duration_ms(), 0, 1, skip_ready_check);
+}
+
+bool PeshoSomfyComponent::prepare_press(uint8_t button_mask, const char *button_name, bool skip_ready_check) {
+  for (uint8_t button = 0; button < NUM_BUTTONS; button++) {
+    if ((button_mask & (1 << button)) && this->button_pins_[button] == nullptr) {
+      ESP_LOGW(TAG, "Attempted to press %s but pin is not configured", button_name);
+      return false;
+    }
   }
   
   // Check if ready to accept new operations (unless called internally)
   if (!skip_ready_check && !this->is_ready()) {
     ESP_LOGW(TAG, "Device busy (%s), ignoring %s button press", this->get_busy_reason(), button_name);
-    return;
+    return false;
+  }
+  
+  // Never reprogram a running channel: release + press without a gap reads as one long press
+  if (this->active_buttons_ & button_mask) {
+    ESP_LOGW(TAG, "%s button still pressed, ignoring new press", button_name);
+    return false;
   }
-
-  ESP_LOGD(TAG, "Pressing %s button", button_name);
 
   // If this is the select_cover_pin_ and we're in selection phase, increment cover index
-  if (pin == this->select_cover_pin_ && 
-      (this->select_cover_state_ == SELECT_COVER_WAITING_FOR_BUTTON_RELEASE || 
-       this->select_cover_state_ == SELECT_COVER_WAITING_FOR_NEXT_PRESS)) {
+  if ((button_mask & (1 << BUTTON_SELECT)) && 
+      (this->select_op_.state == SELECT_COVER_WAITING_FOR_BUTTON_RELEASE || 
+       this->select_op_.state == SELECT_COVER_WAITING_FOR_NEXT_PRESS)) {
     // This is a selection press - will increment cover index after release
     this->pending_cover_index_increment_ = true;
-  } else {
+  } else if (button_mask & (1 << BUTTON_SELECT)) {
     // Manual press or reset phase press - don't increment cover index
     this->pending_cover_index_increment_ = false;
   }
+  return true;
+}
+
+void PeshoSomfyComponent::start_press(uint8_t button_mask, const char *button_name, uint32_t on_ms, 
+                                      uint32_t period_ms, uint8_t count, bool skip_ready_check) {
+  if (!this->prepare_press(button_mask, button_name, skip_ready_check)) {
+    return;
+  }
+  
+  // Keep a gap between pulses, otherwise the remote sees one long press
+  period_ms = std::max(period_ms, on_ms + MIN_PULSE_GAP_MS);
+  if (count > 1) {
+    ESP_LOGD(TAG, "Pressing %s button %u times (%u ms every %u ms)", button_name, count, on_ms, period_ms);
+  } else {
+    ESP_LOGD(TAG, "Pressing %s button", button_name);
+  }
+
+  // All buttons of a chord start in the same loop iteration
+  for (uint8_t button = 0; button < NUM_BUTTONS; button++) {
+    if (button_mask & (1 << button)) {
+      this->schedule_pulses(static_cast<RemoteButton>(button), 0, on_ms, period_ms, count);
+    }
+  }
+}
+
+void PeshoSomfyComponent::press_buttons(uint8_t button_mask, uint32_t duration_ms) {
+  if (button_mask == 0 || button_mask >= (1 << NUM_BUTTONS)) {
+    ESP_LOGW(TAG, "Invalid button mask 0x%02X for chord/long press", button_mask);
+    return;
+  }
+  this->start_press(button_mask, "Chord/long press", duration_ms, 0, 1, false);
+}
+
+void PeshoSomfyComponent::press_pattern(std::initializer_list<ButtonPulse> pulses) {
+  uint8_t button_mask = 0;
+  for (const ButtonPulse &pulse : pulses) {
+    if (pulse.button >= NUM_BUTTONS || (button_mask & (1 << pulse.button))) {
+      ESP_LOGW(TAG, "Invalid press pattern: each button may appear only once");
+      return;
+    }
+    button_mask |= (1 << pulse.button);
+  }
+  if (button_mask == 0 || !this->prepare_press(button_mask, "Pattern", false)) {
+    return;
+  }
+  
+  for (const ButtonPulse &pulse : pulses) {
+    ESP_LOGD(TAG, "Pressing %s button at +%u ms for %u ms", BUTTON_NAMES[pulse.button], 
+             pulse.start_delay_ms, pulse.duration_ms);
+    this->schedule_pulses(pulse.button, pulse.start_delay_ms, pulse.duration_ms, 0, 1);
+  }
+}
+
+void PeshoSomfyComponent::pulse_train(RemoteButton button, uint8_t count, uint32_t on_ms, uint32_t period_ms) {
+  if (button >= NUM_BUTTONS || count == 0) {
+    return;
+  }
+  this->start_press(1 << button, BUTTON_NAMES[button], on_ms, period_ms, count, false);
+}
+
+void PeshoSomfyComponent::schedule_pulses(RemoteButton button, uint32_t start_delay_ms, uint32_t on_ms, 
+                                          uint32_t period_ms, uint8_t count) {
+  PulseChannel &channel = this->pulse_channels_[button];
+  
+  channel.start_time = millis() + start_delay_ms;
+  channel.on_ms = on_ms;
+  channel.period_ms = period_ms;
+  channel.pulses_remaining = count;
+  channel.pressed = false;
+  this->active_buttons_ |= (1 << button);
+  this->high_freq_loop_.start();
+  
+  if (start_delay_ms == 0) {
+    this->set_pin_pressed(this->button_pins_[button]);
+    channel.pressed = true;
+  }
+}
 
+void PeshoSomfyComponent::set_pin_pressed(InternalGPIOPin *pin) {
   // Safe button press sequence:
   // 1. Set LOW first (sets internal latch) to avoid any HIGH pulse
   // 2. Configure as OUTPUT (pin now sinks current to GND)
-  // 3. Track state for non-blocking release
-  // 4. Release will happen in loop() after duration
-
+  // 3. Release will happen in loop() after the pulse length (back to INPUT)
   pin->digital_write(false);  // Set LOW first
   pin->pin_mode(gpio::FLAG_OUTPUT);  // Then configure as OUTPUT
-
-  // Store state for non-blocking release
-  this->active_button_pin_ = pin;
-  this->active_button_name_ = button_name;
-  this->button_press_start_time_ = millis();
 }
 
-void PeshoSomfyComponent::release_button_if_done() {
-  if (this->active_button_pin_ == nullptr) {
+void PeshoSomfyComponent::update_pulse_engine() {
+  if (this->active_buttons_ == 0) {
     return;  // No button being pressed
   }
 
   uint32_t now = millis();
-  uint32_t elapsed = now - this->button_press_start_time_;
-
-  if (elapsed >= this->button_press_duration_ms_) {
+  for (uint8_t button = 0; button < NUM_BUTTONS; button++) {
+    PulseChannel &channel = this->pulse_channels_[button];
+    if (channel.pulses_remaining == 0) {
+      continue;
+    }
+    InternalGPIOPin *pin = this->button_pins_[button];
+    
+    // Signed compare: start times in the future stay correct across millis() rollover
+    if (!channel.pressed && static_cast<int32_t>(now - channel.start_time) >= 0) {
+      this->set_pin_pressed(pin);
+      channel.pressed = true;
+    }
+    
+    if (!channel.pressed || now - channel.start_time < channel.on_ms) {
+      continue;
+    }
+    
     // Release button: Set back to INPUT (floating, high impedance)
-    this->active_button_pin_->pin_mode(gpio::FLAG_INPUT);
+    pin->pin_mode(gpio::FLAG_INPUT);
+    channel.pressed = false;
+    channel.pulses_remaining--;
+    // Every release counts for the queue's release gap, a train may be cut between pulses
+    this->last_release_time_ = now;
+    this->last_released_button_ = static_cast<RemoteButton>(button);
+    if (channel.pulses_remaining > 0) {
+      channel.start_time += channel.period_ms;  // Next pulse of the train
+      continue;
+    }
     
-    ESP_LOGD(TAG, "%s button released", this->active_button_name_);
+    ESP_LOGD(TAG, "%s button released", BUTTON_NAMES[button]);
+    this->active_buttons_ &= ~(1 << button);
     
     // Handle cover index increment if needed
-    if (this->pending_cover_index_increment_) {
+    if (button == BUTTON_SELECT && this->pending_cover_index_increment_) {
       this->current_cover_index_ = (this->current_cover_index_ + 1) % NUM_COVERS;
       ESP_LOGD(TAG, "Cover index incremented to: %u", this->current_cover_index_);
       this->pending_cover_index_increment_ = false;
     }
-    
-    // Clear active button state
-    this->active_button_pin_ = nullptr;
-    this->active_button_name_ = nullptr;
   }
+  
+  if (this->active_buttons_ == 0) {
+    this->high_freq_loop_.stop();
+    this->active_command_.action = COVER_ACTION_NONE;
+  }
+}
+
+void PeshoSomfyComponent::truncate_pulse_trains() {
+  uint32_t press_duration_ms = this->get_press_duration_ms();
+  uint8_t pulses_cut = 0;
+  bool hold_cut = false;
+  for (uint8_t button = 0; button < NUM_BUTTONS; button++) {
+    PulseChannel &channel = this->pulse_channels_[button];
+    if (channel.pulses_remaining == 0) {
+      continue;
+    }
+    if (channel.pressed) {
+      pulses_cut = std::max<uint8_t>(pulses_cut, channel.pulses_remaining - 1);
+      channel.pulses_remaining = 1;  // Finish the current pulse only
+      if (channel.on_ms > press_duration_ms) {
+        channel.on_ms = press_duration_ms;  // Long hold: release after a normal press
+        hold_cut = true;
+      }
+    } else {
+      pulses_cut = std::max(pulses_cut, channel.pulses_remaining);
+      channel.pulses_remaining = 0;  // Next pulse hasn't started yet, drop it
+      this->active_buttons_ &= ~(1 << button);
+      // Already released: last_release_time_ was recorded then, so the release gap still applies
+      ESP_LOGD(TAG, "%s button released (train cut)", BUTTON_NAMES[button]);
+      if (button == BUTTON_SELECT) {
+        this->pending_cover_index_increment_ = false;
+      }
+    }
+  }
+  
+  // Re-plan what the STOP cut off: the remaining tilt steps, or the whole hold
+  if (this->active_command_.action != COVER_ACTION_NONE && (pulses_cut > 0 || hold_cut)) {
+    CoverCommand remaining = this->active_command_;
+    if (!hold_cut) {
+      remaining.repeat = pulses_cut;
+    }
+    ESP_LOGI(TAG, "%s for Remote Cover %u cut short by STOP", COVER_ACTION_TABLE[remaining.action].name, 
+             remaining.cover_index + 1);
+    this->replan_interrupted_command(remaining);
+  }
+  this->active_command_.action = COVER_ACTION_NONE;  // Re-plan only once
+  
+  if (this->active_buttons_ == 0) {
+    this->high_freq_loop_.stop();
+  }
+}
+
+void PeshoSomfyComponent::press_action(CoverCommand command) {
+  const CoverActionInfo &info = COVER_ACTION_TABLE[command.action];
+  uint32_t on_ms = info.press == ACTION_PRESS_LONG ? this->long_press_duration_ms_ : this->get_press_duration_ms();
+  uint8_t count = info.press == ACTION_PRESS_TRAIN ? std::max<uint8_t>(command.repeat, 1) : 1;
+  this->start_press(info.button_mask, info.name, on_ms, 0, count, true);
+  this->active_command_ = command;
+}
+
+void PeshoSomfyComponent::execute_pending_action() {
+  CoverCommand command = this->select_op_.command;
+  this->select_op_.command.action = COVER_ACTION_NONE;
+  if (command.action == COVER_ACTION_NONE) {
+    return;
+  }
+  // A STOP waiting for another cover goes first, this action is re-planned after it
+  if (command.action != COVER_ACTION_MY && this->preempt_stop_mask_ != 0) {
+    this->replan_interrupted_command(command);
+    return;
+  }
+  ESP_LOGI(TAG, "Executing pending action: Press %s for Remote Cover %u", 
+           COVER_ACTION_TABLE[command.action].name, command.cover_index + 1);
+  this->press_action(command);
 }
 
 void PeshoSomfyComponent::press_select_cover() {
   // Manual press: Will be blocked if device is busy (checked in press_button)
-  this->press_button(this->select_cover_pin_, "Select Cover", false);
+  this->press_button(BUTTON_SELECT, BUTTON_NAMES[BUTTON_SELECT], false);
 }
 
 void PeshoSomfyComponent::press_up() {
-  this->press_button(this->up_pin_, "Up");
+  this->press_button(BUTTON_UP, BUTTON_NAMES[BUTTON_UP]);
 }
 
 void PeshoSomfyComponent::press_down() {
-  this->press_button(this->down_pin_, "Down");
+  this->press_button(BUTTON_DOWN, BUTTON_NAMES[BUTTON_DOWN]);
 }
 
 void PeshoSomfyComponent::press_my() {
-  this->press_button(this->my_pin_, "My");
+  this->press_button(BUTTON_MY, BUTTON_NAMES[BUTTON_MY]);
 }
 
 bool PeshoSomfyComponent::get_led3_state() const {
@@ -208,6 +414,7 @@ bool PeshoSomfyComponent::get_led4_binary_sensor_state() const {
 
 void PeshoSomfyComponent::calibrate_cover_index() {
   this->current_cover_index_ = 3;
+  this->cover_index_known_ = true;
   ESP_LOGI(TAG, "Cover index calibrated to: %u (Remote Cover %u)", 
            this->current_cover_index_, this->current_cover_index_ + 1);
 }
@@ -239,6 +446,17 @@ void PeshoSomfyComponent::sync_cover_index_from_leds() {
     return;  // Don't sync during erratic state
   }
   
+  // While degraded only a clean LED3 reading is trusted, and it means the reset anchor works again
+  if (this->degraded_) {
+    if (detected_cover != 2) {
+      return;
+    }
+    ESP_LOGI(TAG, "LED3 anchor detected again");
+    this->clear_degraded();
+  }
+  
+  this->cover_index_known_ = true;
+  
   // Only update if different from current
   if (detected_cover != this->current_cover_index_) {
     ESP_LOGI(TAG, "Syncing cover index from LEDs: %u -> %u (Remote Cover %u)", 
@@ -255,66 +473,104 @@ void PeshoSomfyComponent::select_cover(uint8_t target_cover_index) {
     return;
   }
   
-  // If a select cover operation is already in progress, cancel it first
-  if (this->select_cover_state_ != SELECT_COVER_IDLE) {
-    ESP_LOGI(TAG, "Cancelling previous select cover operation to start new one");
-    this->select_cover_state_ = SELECT_COVER_IDLE;
-    // Release any active button press for select_cover
-    if (this->active_button_pin_ == this->select_cover_pin_) {
-      this->active_button_pin_ = nullptr;
-      this->active_button_name_ = nullptr;
+  this->submit_cover_command({target_cover_index, COVER_ACTION_NONE, 1});
+}
+
+void PeshoSomfyComponent::submit_cover_command(CoverCommand command) {
+  uint8_t cover_index = command.cover_index;
+  
+  // STOP has priority: instead of being dropped as busy, it preempts whatever is
+  // in flight at the next press boundary (see service_command_queue)
+  if (command.action == COVER_ACTION_MY && (!this->is_ready() || this->preempt_stop_mask_ != 0)) {
+    // Stopping the cover that is being selected right now: just replace its pending action
+    if (this->select_op_.state != SELECT_COVER_IDLE && this->select_op_.command.cover_index == cover_index) {
+      ESP_LOGI(TAG, "STOP for Remote Cover %u replaces pending action of in-flight selection", cover_index + 1);
+      this->select_op_.command.action = COVER_ACTION_MY;
+      return;
+    }
+    
+    // A deferred command for the same cover is superseded by the stop
+    if (this->deferred_mask_ & (1 << cover_index)) {
+      ESP_LOGI(TAG, "STOP for Remote Cover %u supersedes its deferred command", cover_index + 1);
+      this->deferred_mask_ &= ~(1 << cover_index);
     }
+    
+    ESP_LOGI(TAG, "STOP for Remote Cover %u queued to preempt current operation (%s)", 
+             cover_index + 1, this->get_busy_reason());
+    this->preempt_stop_mask_ |= (1 << cover_index);
+    return;
   }
   
-  // Check if ready to accept new operations (should be ready now after cancellation)
-  if (!this->is_ready()) {
-    ESP_LOGW(TAG, "Device busy (%s), cannot start select cover", this->get_busy_reason());
+  // Other commands never cancel work in progress, they wait for the next press boundary.
+  // One command is kept per cover, only a newer command for the same cover replaces it.
+  if (!this->is_ready() || this->preempt_stop_mask_ != 0) {
+    if (this->deferred_mask_ & (1 << cover_index)) {
+      ESP_LOGI(TAG, "Replacing deferred %s for Remote Cover %u with newer %s", 
+               COVER_ACTION_TABLE[this->deferred_commands_[cover_index].action].name, cover_index + 1, 
+               COVER_ACTION_TABLE[command.action].name);
+    } else {
+      ESP_LOGI(TAG, "Device busy (%s), deferring command for Remote Cover %u", 
+               this->get_busy_reason(), cover_index + 1);
+    }
+    this->deferred_commands_[cover_index] = command;
+    this->deferred_mask_ |= (1 << cover_index);
     return;
   }
   
-  // Check if already at target
-  if (this->current_cover_index_ == target_cover_index) {
-    ESP_LOGI(TAG, "Already at Remote Cover %u (Index %u), no selection needed", 
-             target_cover_index + 1, target_cover_index);
-    
-    // Execute pending action if any (cover_open/cover_close/cover_stop may have set it)
-    if (this->pending_action_ == PENDING_ACTION_PRESS_UP) {
-      this->pending_action_ = PENDING_ACTION_NONE;
-      ESP_LOGI(TAG, "Executing pending action: Press UP for Remote Cover %u", target_cover_index + 1);
-      this->press_up();
-    } else if (this->pending_action_ == PENDING_ACTION_PRESS_DOWN) {
-      this->pending_action_ = PENDING_ACTION_NONE;
-      ESP_LOGI(TAG, "Executing pending action: Press DOWN for Remote Cover %u", target_cover_index + 1);
-      this->press_down();
-    } else if (this->pending_action_ == PENDING_ACTION_PRESS_MY) {
-      this->pending_action_ = PENDING_ACTION_NONE;
-      ESP_LOGI(TAG, "Executing pending action: Press MY for Remote Cover %u", target_cover_index + 1);
-      this->press_my();
+  this->dispatch_cover_command(command);
+}
+
+void PeshoSomfyComponent::dispatch_cover_command(CoverCommand command) {
+  uint8_t cover_index = command.cover_index;
+  
+  // Check if already at target cover
+  if (this->cover_index_known_ && this->current_cover_index_ == cover_index) {
+    if (command.action == COVER_ACTION_NONE) {
+      ESP_LOGI(TAG, "Already at Remote Cover %u (Index %u), no selection needed", cover_index + 1, cover_index);
+      return;
     }
+    ESP_LOGI(TAG, "Already at Remote Cover %u (Index %u), pressing %s", 
+             cover_index + 1, cover_index, COVER_ACTION_TABLE[command.action].name);
+    this->press_action(command);
+    return;
+  }
+  
+  // Fail fast instead of burning reset presses on every command
+  if (this->degraded_) {
+    ESP_LOGW(TAG, "Degraded (%s), rejecting command for Remote Cover %u", 
+             this->degraded_reason_, cover_index + 1);
     return;
   }
   
+  // Set pending action and select cover
+  this->select_op_.command = command;
+  this->start_select_cover(cover_index);
+}
+
+void PeshoSomfyComponent::start_select_cover(uint8_t target_cover_index) {
   // Validate binary sensors are configured
   if (this->led3_binary_sensor_ == nullptr || this->led4_binary_sensor_ == nullptr) {
     ESP_LOGW(TAG, "Cannot select cover - binary sensors not configured");
+    this->select_op_.command.action = COVER_ACTION_NONE;
     return;
   }
   
-  // Check if LED3 is already on (we're at cover 3)
-  bool led3_on = get_led3_binary_sensor_state();
-  bool led4_on = get_led4_binary_sensor_state();
+  // Check if an anchor LED is already on (LED3, or LED4 once it was needed as fallback)
+  this->recovery_stage_ = RECOVERY_NONE;
+  uint8_t anchor_index = this->detect_anchor(get_led3_binary_sensor_state(), get_led4_binary_sensor_state());
   
-  // Calculate presses needed from cover 3 (index 2) to target
-  uint8_t presses_needed = (target_cover_index - 2 + NUM_COVERS) % NUM_COVERS;
+  // Calculate presses needed from the anchor (cover 3 = index 2 when resetting) to target
+  uint8_t presses_needed = (target_cover_index - (anchor_index < NUM_COVERS ? anchor_index : 2) + NUM_COVERS) % NUM_COVERS;
   
-  this->select_cover_target_ = target_cover_index;
-  this->select_cover_presses_remaining_ = presses_needed;
-  this->select_cover_press_count_ = 0;
+  this->select_op_.command.cover_index = target_cover_index;
+  this->select_op_.presses_remaining = presses_needed;
+  this->select_op_.press_count = 0;
   
-  if (led3_on && !led4_on) {
-    // Already at cover 3, skip reset phase
-    ESP_LOGI(TAG, "Already at Remote Cover 3 (Index 2), skipping reset phase");
-    this->current_cover_index_ = 2;
+  if (anchor_index < NUM_COVERS) {
+    // Already at the anchor cover, skip reset phase
+    ESP_LOGI(TAG, "Already at Remote Cover %u (Index %u), skipping reset phase", anchor_index + 1, anchor_index);
+    this->current_cover_index_ = anchor_index;
+    this->cover_index_known_ = true;
     
     if (presses_needed == 0) {
       // Already at target
@@ -322,36 +578,262 @@ void PeshoSomfyComponent::select_cover(uint8_t target_cover_index) {
                target_cover_index + 1, target_cover_index);
       
       // Execute pending action if any
-      if (this->pending_action_ == PENDING_ACTION_PRESS_UP) {
-        this->pending_action_ = PENDING_ACTION_NONE;
-        ESP_LOGI(TAG, "Executing pending action: Press UP for Remote Cover %u", target_cover_index + 1);
-        this->press_up();
-      } else if (this->pending_action_ == PENDING_ACTION_PRESS_DOWN) {
-        this->pending_action_ = PENDING_ACTION_NONE;
-        ESP_LOGI(TAG, "Executing pending action: Press DOWN for Remote Cover %u", target_cover_index + 1);
-        this->press_down();
-      } else if (this->pending_action_ == PENDING_ACTION_PRESS_MY) {
-        this->pending_action_ = PENDING_ACTION_NONE;
-        ESP_LOGI(TAG, "Executing pending action: Press MY for Remote Cover %u", target_cover_index + 1);
-        this->press_my();
-      }
+      this->execute_pending_action();
       return;
     }
     
     // Start selection phase directly
-    ESP_LOGI(TAG, "Selecting Remote Cover %u (Index %u) from Cover 3 - %u presses needed", 
-             target_cover_index + 1, target_cover_index, presses_needed);
-    this->select_cover_state_ = SELECT_COVER_WAITING_FOR_BUTTON_RELEASE;
-    this->select_cover_wait_start_time_ = millis();
-    this->press_button(this->select_cover_pin_, "Select Cover (Select)", true);
+    ESP_LOGI(TAG, "Selecting Remote Cover %u (Index %u) from Cover %u - %u presses needed", 
+             target_cover_index + 1, target_cover_index, anchor_index + 1, presses_needed);
+    this->select_op_.state = SELECT_COVER_WAITING_FOR_BUTTON_RELEASE;
+    this->select_op_.wait_start_time = millis();
+    this->press_button(BUTTON_SELECT, "Select Cover (Select)", true);
   } else {
     // Need to reset to cover 3 first
-    ESP_LOGI(TAG, "Resetting to Remote Cover 3 (Index 2), then selecting Remote Cover %u (Index %u) - %u presses needed", 
-             target_cover_index + 1, target_cover_index, presses_needed);
-    this->select_cover_state_ = SELECT_COVER_RESETTING_TO_COVER3;
-    this->select_cover_reset_press_count_ = 1;
-    this->select_cover_wait_start_time_ = millis();
-    this->press_button(this->select_cover_pin_, "Select Cover (Reset)", true);
+    ESP_LOGI(TAG, "Resetting to %s, then selecting Remote Cover %u (Index %u)", 
+             this->led4_anchor_learned_ ? "Remote Cover 3 or 4 (LED3/LED4 anchor)" : "Remote Cover 3 (Index 2)", 
+             target_cover_index + 1, target_cover_index);
+    this->start_reset_phase();
+  }
+}
+
+uint8_t PeshoSomfyComponent::detect_anchor(bool led3_on, bool led4_on) const {
+  if (led3_on && !led4_on) {
+    return 2;
+  }
+  // LED4 is accepted as alternative anchor during recovery, and afterwards once it worked
+  if (led4_on && !led3_on && (this->led4_anchor_learned_ || this->recovery_stage_ != RECOVERY_NONE)) {
+    return 3;
+  }
+  return NUM_COVERS;
+}
+
+void PeshoSomfyComponent::start_reset_phase() {
+  this->reset_led3_seen_ = false;
+  this->reset_led4_seen_ = false;
+  this->reset_raw_led3_seen_ = false;
+  this->reset_led_changes_ = 0;
+  this->reset_last_led_state_ = (this->get_led3_binary_sensor_state() ? 1 : 0) | 
+                                (this->get_led4_binary_sensor_state() ? 2 : 0);
+  
+  this->select_op_.state = SELECT_COVER_RESETTING_TO_COVER3;
+  this->select_op_.reset_press_count = 1;
+  this->select_op_.wait_start_time = millis();
+  this->press_button(BUTTON_SELECT, "Select Cover (Reset)", true);
+}
+
+void PeshoSomfyComponent::record_reset_observation(bool led3_on, bool led4_on) {
+  uint8_t led_state = (led3_on ? 1 : 0) | (led4_on ? 2 : 0);
+  if (led_state != this->reset_last_led_state_) {
+    this->reset_led_changes_++;
+    this->reset_last_led_state_ = led_state;
+  }
+  this->reset_led3_seen_ |= led3_on;
+  this->reset_led4_seen_ |= led4_on;
+  this->reset_raw_led3_seen_ |= this->get_led3_state();
+}
+
+const char *PeshoSomfyComponent::diagnose_reset_failure() const {
+  if (this->reset_led_changes_ == 0 && this->reset_last_led_state_ != 0) {
+    return "LED pin stuck ON";
+  }
+  if (this->reset_raw_led3_seen_ && !this->reset_led3_seen_) {
+    return "LED3 sensor misconfigured (raw pin lit, sensor never ON)";
+  }
+  if (this->reset_led_changes_ == 0) {
+    return "No LED activity (remote asleep or LED wiring)";
+  }
+  if (this->reset_led4_seen_ && !this->reset_led3_seen_) {
+    return "LED3 never lit (LED3 pin stuck OFF)";
+  }
+  return "LED3 not detected";
+}
+
+void PeshoSomfyComponent::handle_reset_failure() {
+  const char *diagnosis = this->diagnose_reset_failure();
+  ESP_LOGW(TAG, "Reset phase failed after %u presses - LED3 did not light up (%s)", 
+           this->select_op_.reset_press_count, diagnosis);
+  
+  // Recovery pipeline: LED4 as alternative anchor, then slow timing profile, then give up.
+  // A stuck LED can't be fixed by pressing more, so that fails immediately.
+  bool led_stuck = this->reset_led_changes_ == 0 && this->reset_last_led_state_ != 0;
+  if (!led_stuck) {
+    if (this->recovery_stage_ == RECOVERY_NONE) {
+      this->recovery_reason_ = diagnosis;  // Reported while a fallback that worked stays in use
+    }
+    if (this->recovery_stage_ == RECOVERY_NONE && this->reset_led4_seen_ && !this->led4_anchor_learned_) {
+      ESP_LOGW(TAG, "Recovery: retrying reset with LED4 (Remote Cover 4) as alternative anchor");
+      this->recovery_stage_ = RECOVERY_LED4_ANCHOR;
+      this->start_reset_phase();
+      return;
+    }
+    if (this->recovery_stage_ != RECOVERY_SLOW_TIMING && this->timing_scale_ == 1) {
+      ESP_LOGW(TAG, "Recovery: retrying reset with slow timing profile (x%u)", SLOW_TIMING_SCALE);
+      this->recovery_stage_ = RECOVERY_SLOW_TIMING;
+      this->timing_scale_ = SLOW_TIMING_SCALE;
+      this->start_reset_phase();
+      return;
+    }
+  }
+  
+  // Recovery failed: mark degraded so later commands fail fast
+  this->select_op_.state = SELECT_COVER_IDLE;
+  this->recovery_stage_ = RECOVERY_NONE;
+  this->slow_timing_learned_ = false;
+  this->led4_anchor_learned_ = false;
+  this->timing_scale_ = 1;
+  this->cover_index_known_ = false;
+  this->last_select_cover_complete_time_ = millis();
+  
+  // Clear pending action on failure
+  if (this->select_op_.command.action != COVER_ACTION_NONE) {
+    ESP_LOGW(TAG, "Clearing pending action due to select_cover failure");
+    this->select_op_.command.action = COVER_ACTION_NONE;
+  }
+  
+  this->set_degraded(diagnosis);
+}
+
+void PeshoSomfyComponent::set_degraded(const char *reason) {
+  this->degraded_ = true;
+  this->degraded_reason_ = reason;
+  ESP_LOGE(TAG, "Component degraded: %s - cover selection disabled until cleared", reason);
+  this->status_set_warning();
+  this->publish_status();
+}
+
+void PeshoSomfyComponent::clear_degraded() {
+  if (this->degraded_) {
+    ESP_LOGI(TAG, "Clearing degraded state (%s)", this->degraded_reason_);
+  } else if (this->slow_timing_learned_ || this->led4_anchor_learned_) {
+    ESP_LOGI(TAG, "Forgetting learned recovery fallbacks (%s)", this->recovery_reason_);
+  } else {
+    return;
+  }
+  this->degraded_ = false;
+  this->degraded_reason_ = "";
+  this->recovery_reason_ = "";
+  this->slow_timing_learned_ = false;
+  this->led4_anchor_learned_ = false;
+  this->timing_scale_ = 1;
+  this->status_clear_warning();
+  this->publish_status();
+}
+
+void PeshoSomfyComponent::publish_status() {
+  if (this->status_text_sensor_ == nullptr) {
+    return;
+  }
+  if (this->degraded_) {
+    this->status_text_sensor_->publish_state(std::string("Degraded: ") + this->degraded_reason_);
+  } else if (this->led4_anchor_learned_ || this->slow_timing_learned_) {
+    std::string status = "Recovered: ";
+    if (this->led4_anchor_learned_) {
+      status += "LED4 anchor";
+    }
+    if (this->led4_anchor_learned_ && this->slow_timing_learned_) {
+      status += " + ";
+    }
+    if (this->slow_timing_learned_) {
+      status += "slow timing";
+    }
+    this->status_text_sensor_->publish_state(status + " (" + this->recovery_reason_ + ")");
+  } else {
+    this->status_text_sensor_->publish_state("OK");
+  }
+}
+
+void PeshoSomfyComponent::service_command_queue() {
+  if (this->preempt_stop_mask_ == 0 && this->deferred_mask_ == 0) {
+    return;  // Nothing waiting
+  }
+  
+  // Only act on a press boundary: the press in progress is allowed to finish
+  // (at most one button press duration), so the tracked cover index stays consistent.
+  // A stop that is already being executed is never preempted.
+  if (this->active_buttons_ != 0 || this->stop_in_flight()) {
+    // Pulse trains (e.g. tilt steps) are cut after the current pulse so a STOP isn't held up
+    if (this->preempt_stop_mask_ != 0) {
+      this->truncate_pulse_trains();
+    }
+    return;
+  }
+  
+  // Keep the same gap after the last release as the state machine does between selection presses,
+  // otherwise the remote sees a release immediately followed by a press of the same button as one long press
+  uint32_t release_gap = this->last_released_button_ == BUTTON_SELECT ? 
+                         this->get_press_duration_ms() + SELECT_COVER_PRESS_MARGIN_MS : SELECT_COVER_PRESS_MARGIN_MS;
+  if (millis() - this->last_release_time_ < release_gap) {
+    return;
+  }
+  
+  if (this->preempt_stop_mask_ != 0) {
+    if (this->select_op_.state != SELECT_COVER_IDLE) {
+      this->abort_select_cover();
+    }
+    
+    uint8_t cover_index = this->next_queued_cover(this->preempt_stop_mask_);
+    this->preempt_stop_mask_ &= ~(1 << cover_index);
+    
+    ESP_LOGI(TAG, "Executing preempting STOP for Remote Cover %u", cover_index + 1);
+    this->dispatch_cover_command({cover_index, COVER_ACTION_MY, 1});
+    return;
+  }
+  
+  // Deferred command: let the selection in progress finish and execute its action first
+  if (this->select_op_.state != SELECT_COVER_IDLE) {
+    return;
+  }
+  
+  uint8_t cover_index = this->next_queued_cover(this->deferred_mask_);
+  this->deferred_mask_ &= ~(1 << cover_index);
+  ESP_LOGI(TAG, "Starting deferred command for Remote Cover %u", cover_index + 1);
+  this->dispatch_cover_command(this->deferred_commands_[cover_index]);
+}
+
+uint8_t PeshoSomfyComponent::next_queued_cover(uint8_t cover_mask) const {
+  // Prefer the currently selected cover (no selection presses needed), otherwise the lowest index
+  if (this->cover_index_known_ && (cover_mask & (1 << this->current_cover_index_))) {
+    return this->current_cover_index_;
+  }
+  uint8_t cover_index = 0;
+  while (!(cover_mask & (1 << cover_index))) {
+    cover_index++;
+  }
+  return cover_index;
+}
+
+void PeshoSomfyComponent::abort_select_cover() {
+  ESP_LOGI(TAG, "Aborting select cover operation for Remote Cover %u", this->select_op_.command.cover_index + 1);
+  
+  // Reset phase presses don't update the tracked index, so we no longer know where we are.
+  // Selection phase presses are counted on release, so the index is still valid there.
+  if (this->select_op_.state == SELECT_COVER_RESETTING_TO_COVER3 ||
+      this->select_op_.state == SELECT_COVER_WAITING_FOR_LED3_STABLE ||
+      this->select_op_.state == SELECT_COVER_CHECKING_LED3) {
+    ESP_LOGD(TAG, "Aborted during reset phase, cover index unknown until next reset or LED sync");
+    this->cover_index_known_ = false;
+  }
+  
+  this->replan_interrupted_command(this->select_op_.command);
+  
+  this->select_op_.command.action = COVER_ACTION_NONE;
+  this->select_op_.state = SELECT_COVER_IDLE;
+  this->recovery_stage_ = RECOVERY_NONE;
+  this->timing_scale_ = this->slow_timing_learned_ ? SLOW_TIMING_SCALE : 1;  // Drop an unconfirmed slow retry
+  this->last_select_cover_complete_time_ = millis();
+}
+
+void PeshoSomfyComponent::replan_interrupted_command(CoverCommand command) {
+  if (this->preempt_stop_mask_ & (1 << command.cover_index)) {
+    ESP_LOGI(TAG, "Interrupted command for Remote Cover %u superseded by STOP", command.cover_index + 1);
+  } else if (this->deferred_mask_ & (1 << command.cover_index)) {
+    ESP_LOGI(TAG, "Interrupted command for Remote Cover %u superseded by newer command for it", 
+             command.cover_index + 1);
+  } else {
+    ESP_LOGI(TAG, "Interrupted command for Remote Cover %u will be re-planned after STOP", command.cover_index + 1);
+    this->deferred_commands_[command.cover_index] = command;
+    this->deferred_mask_ |= (1 << command.cover_index);
   }
 }
 
@@ -361,83 +843,87 @@ void PeshoSomfyComponent::cover_open(uint8_t cover_index) {
     return;
   }
   
-  // Check if already at target cover
-  if (this->current_cover_index_ == cover_index && this->select_cover_state_ == SELECT_COVER_IDLE) {
-    // Already at target, just press up
-    ESP_LOGI(TAG, "Already at Remote Cover %u (Index %u), pressing UP", cover_index + 1, cover_index);
-    this->press_up();
+  ESP_LOGI(TAG, "Opening Remote Cover %u (Index %u)", cover_index + 1, cover_index);
+  this->submit_cover_command({cover_index, COVER_ACTION_UP, 1});
+}
+
+void PeshoSomfyComponent::cover_close(uint8_t cover_index) {
+  if (cover_index > 4) {
+    ESP_LOGW(TAG, "Invalid cover index for close: %u (must be 0-4)", cover_index);
     return;
   }
   
-  // Set pending action and select cover
-  ESP_LOGI(TAG, "Opening Remote Cover %u (Index %u) - selecting cover first", cover_index + 1, cover_index);
-  this->pending_action_ = PENDING_ACTION_PRESS_UP;
-  this->select_cover(cover_index);
+  ESP_LOGI(TAG, "Closing Remote Cover %u (Index %u)", cover_index + 1, cover_index);
+  this->submit_cover_command({cover_index, COVER_ACTION_DOWN, 1});
 }
 
-void PeshoSomfyComponent::cover_close(uint8_t cover_index) {
+void PeshoSomfyComponent::cover_stop(uint8_t cover_index) {
   if (cover_index > 4) {
-    ESP_LOGW(TAG, "Invalid cover index for close: %u (must be 0-4)", cover_index);
+    ESP_LOGW(TAG, "Invalid cover index for stop: %u (must be 0-4)", cover_index);
     return;
   }
   
-  // Check if already at target cover
-  if (this->current_cover_index_ == cover_index && this->select_cover_state_ == SELECT_COVER_IDLE) {
-    // Already at target, just press down
-    ESP_LOGI(TAG, "Already at Remote Cover %u (Index %u), pressing DOWN", cover_index + 1, cover_index);
-    this->press_down();
+  ESP_LOGI(TAG, "Stopping Remote Cover %u (Index %u)", cover_index + 1, cover_index);
+  this->submit_cover_command({cover_index, COVER_ACTION_MY, 1});
+}
+
+void PeshoSomfyComponent::cover_hold_my(uint8_t cover_index) {
+  if (cover_index > 4) {
+    ESP_LOGW(TAG, "Invalid cover index for hold MY: %u (must be 0-4)", cover_index);
     return;
   }
   
-  // Set pending action and select cover
-  ESP_LOGI(TAG, "Closing Remote Cover %u (Index %u) - selecting cover first", cover_index + 1, cover_index);
-  this->pending_action_ = PENDING_ACTION_PRESS_DOWN;
-  this->select_cover(cover_index);
+  ESP_LOGI(TAG, "Holding MY for Remote Cover %u (Index %u)", cover_index + 1, cover_index);
+  this->submit_cover_command({cover_index, COVER_ACTION_HOLD_MY, 1});
 }
 
-void PeshoSomfyComponent::cover_stop(uint8_t cover_index) {
+void PeshoSomfyComponent::cover_up_down(uint8_t cover_index) {
   if (cover_index > 4) {
-    ESP_LOGW(TAG, "Invalid cover index for stop: %u (must be 0-4)", cover_index);
+    ESP_LOGW(TAG, "Invalid cover index for UP+DOWN: %u (must be 0-4)", cover_index);
     return;
   }
   
-  // Check if already at target cover
-  if (this->current_cover_index_ == cover_index && this->select_cover_state_ == SELECT_COVER_IDLE) {
-    // Already at target, just press my
-    ESP_LOGI(TAG, "Already at Remote Cover %u (Index %u), pressing MY", cover_index + 1, cover_index);
-    this->press_my();
+  ESP_LOGI(TAG, "Pressing UP+DOWN for Remote Cover %u (Index %u)", cover_index + 1, cover_index);
+  this->submit_cover_command({cover_index, COVER_ACTION_UP_DOWN, 1});
+}
+
+void PeshoSomfyComponent::cover_tilt(uint8_t cover_index, bool up, uint8_t steps) {
+  if (cover_index > 4) {
+    ESP_LOGW(TAG, "Invalid cover index for tilt: %u (must be 0-4)", cover_index);
+    return;
+  }
+  if (steps == 0) {
     return;
   }
   
-  // Set pending action and select cover
-  ESP_LOGI(TAG, "Stopping Remote Cover %u (Index %u) - selecting cover first", cover_index + 1, cover_index);
-  this->pending_action_ = PENDING_ACTION_PRESS_MY;
-  this->select_cover(cover_index);
+  ESP_LOGI(TAG, "Tilting Remote Cover %u (Index %u) %s by %u steps", 
+           cover_index + 1, cover_index, up ? "up" : "down", steps);
+  this->submit_cover_command({cover_index, up ? COVER_ACTION_TILT_UP : COVER_ACTION_TILT_DOWN, steps});
 }
 
 void PeshoSomfyComponent::handle_select_cover_state_machine() {
   uint32_t now = millis();
   
-  switch (this->select_cover_state_) {
+  switch (this->select_op_.state) {
     case SELECT_COVER_IDLE:
       // Should not happen, but handle gracefully
       break;
       
     case SELECT_COVER_RESETTING_TO_COVER3:
       // Wait for button to be released
-      if (this->active_button_pin_ == nullptr) {
+      if (this->active_buttons_ == 0) {
         // Button released, wait for LED to stabilize
-        this->select_cover_state_ = SELECT_COVER_WAITING_FOR_LED3_STABLE;
-        this->select_cover_wait_start_time_ = now;
+        this->select_op_.state = SELECT_COVER_WAITING_FOR_LED3_STABLE;
+        this->select_op_.wait_start_time = now;
         ESP_LOGD(TAG, "Reset phase: Button released, waiting for LED3 to stabilize (press #%u)", 
-                 this->select_cover_reset_press_count_);
+                 this->select_op_.reset_press_count);
       }
       break;
       
     case SELECT_COVER_WAITING_FOR_LED3_STABLE:
       // Wait for LED3 to stabilize after button release
-      if (now - this->select_cover_wait_start_time_ >= LED_STABLE_DELAY_MS) {
-        this->select_cover_state_ = SELECT_COVER_CHECKING_LED3;
+      if (now - this->select_op_.wait_start_time >= LED_STABLE_DELAY_MS * this->timing_scale_) {
+        this->select_op_.state = SELECT_COVER_CHECKING_LED3;
       }
       break;
       
@@ -445,117 +931,126 @@ void PeshoSomfyComponent::handle_select_cover_state_machine() {
       // Check if LED3 is on (using filtered binary sensor state)
       bool led3_on = get_led3_binary_sensor_state();
       bool led4_on = get_led4_binary_sensor_state();
+      this->record_reset_observation(led3_on, led4_on);
+      
+      // LED3 is the normal anchor, LED4 is accepted as alternative anchor during recovery
+      uint8_t anchor_index = this->detect_anchor(led3_on, led4_on);
       
-      if (led3_on && !led4_on) {
-        // Success! LED3 is on, we're at Cover 3
-        ESP_LOGI(TAG, "Reset phase complete! Remote Cover 3 (Index 2) reached after %u presses", 
-                 this->select_cover_reset_press_count_);
-        this->current_cover_index_ = 2;
+      if (anchor_index < NUM_COVERS) {
+        // Success! We're at a known cover
+        ESP_LOGI(TAG, "Reset phase complete! Remote Cover %u (Index %u) reached after %u presses", 
+                 anchor_index + 1, anchor_index, this->select_op_.reset_press_count);
+        this->current_cover_index_ = anchor_index;
+        this->cover_index_known_ = true;
+        this->select_op_.presses_remaining = (this->select_op_.command.cover_index - anchor_index + NUM_COVERS) % NUM_COVERS;
+        
+        // Remember LED4 as anchor so later commands don't repeat the failing LED3 reset first
+        bool fallback_learned = false;
+        if (anchor_index == 3 && !this->led4_anchor_learned_) {
+          ESP_LOGI(TAG, "Keeping LED4 (Remote Cover 4) as anchor for later commands");
+          this->led4_anchor_learned_ = true;
+          fallback_learned = true;
+        }
+        
+        if (this->recovery_stage_ != RECOVERY_NONE) {
+          ESP_LOGI(TAG, "Reset recovered via %s", 
+                   this->recovery_stage_ == RECOVERY_LED4_ANCHOR ? "LED4 anchor" : "slow timing profile");
+          // The slow profile is only kept once a reset actually succeeded with it
+          if (this->recovery_stage_ == RECOVERY_SLOW_TIMING) {
+            ESP_LOGI(TAG, "Keeping slow timing profile (x%u) for later commands", SLOW_TIMING_SCALE);
+            this->slow_timing_learned_ = true;
+            fallback_learned = true;
+          }
+          this->recovery_stage_ = RECOVERY_NONE;
+        }
+        
+        // Working, but not as configured: tell Home Assistant until the fallbacks are cleared
+        if (fallback_learned) {
+          ESP_LOGW(TAG, "Running on recovery fallback (%s), check the remote and LED wiring", this->recovery_reason_);
+          this->status_set_warning();
+          this->publish_status();
+        }
         
         // Check if we need to do selection phase
-        if (this->select_cover_presses_remaining_ == 0) {
+        if (this->select_op_.presses_remaining == 0) {
           // Already at target
           ESP_LOGI(TAG, "Select cover complete! Already at target Remote Cover %u (Index %u)", 
-                   this->select_cover_target_ + 1, this->select_cover_target_);
-          this->select_cover_state_ = SELECT_COVER_IDLE;
+                   this->select_op_.command.cover_index + 1, this->select_op_.command.cover_index);
+          this->select_op_.state = SELECT_COVER_IDLE;
           this->last_select_cover_complete_time_ = millis();
           
           // Execute pending action if any
-          if (this->pending_action_ == PENDING_ACTION_PRESS_UP) {
-            this->pending_action_ = PENDING_ACTION_NONE;
-            ESP_LOGI(TAG, "Executing pending action: Press UP for Remote Cover %u", this->select_cover_target_ + 1);
-            this->press_up();
-          } else if (this->pending_action_ == PENDING_ACTION_PRESS_DOWN) {
-            this->pending_action_ = PENDING_ACTION_NONE;
-            ESP_LOGI(TAG, "Executing pending action: Press DOWN for Remote Cover %u", this->select_cover_target_ + 1);
-            this->press_down();
-          } else if (this->pending_action_ == PENDING_ACTION_PRESS_MY) {
-            this->pending_action_ = PENDING_ACTION_NONE;
-            ESP_LOGI(TAG, "Executing pending action: Press MY for Remote Cover %u", this->select_cover_target_ + 1);
-            this->press_my();
-          }
+          this->execute_pending_action();
         } else {
           // Start selection phase
           ESP_LOGI(TAG, "Starting selection phase: %u presses needed to reach Remote Cover %u (Index %u)", 
-                   this->select_cover_presses_remaining_, 
-                   this->select_cover_target_ + 1, this->select_cover_target_);
-          this->select_cover_state_ = SELECT_COVER_WAITING_FOR_BUTTON_RELEASE;
-          this->select_cover_wait_start_time_ = now;
-          this->press_button(this->select_cover_pin_, "Select Cover (Select)", true);
-        }
-      } else if (this->select_cover_reset_press_count_ >= MAX_RESET_PRESSES) {
-        // Too many presses, give up
-        ESP_LOGW(TAG, "Reset phase failed after %u presses - LED3 did not light up", 
-                 this->select_cover_reset_press_count_);
-        this->select_cover_state_ = SELECT_COVER_IDLE;
-        
-        // Clear pending action on failure
-        if (this->pending_action_ != PENDING_ACTION_NONE) {
-          ESP_LOGW(TAG, "Clearing pending action due to select_cover failure");
-          this->pending_action_ = PENDING_ACTION_NONE;
+                   this->select_op_.presses_remaining, 
+                   this->select_op_.command.cover_index + 1, this->select_op_.command.cover_index);
+          this->select_op_.wait_start_time = now;
+          if (this->stop_waiting()) {
+            // Give way to a preempting STOP before the first selection press (index is known now)
+            this->select_op_.state = SELECT_COVER_WAITING_FOR_NEXT_PRESS;
+          } else {
+            this->select_op_.state = SELECT_COVER_WAITING_FOR_BUTTON_RELEASE;
+            this->press_button(BUTTON_SELECT, "Select Cover (Select)", true);
+          }
         }
+      } else if (this->stop_waiting()) {
+        // Give way to a preempting STOP instead of pressing again, the command is re-planned after it
+      } else if (this->select_op_.reset_press_count >= 
+                 (this->recovery_stage_ == RECOVERY_NONE ? MAX_RESET_PRESSES : RECOVERY_RESET_PRESSES)) {
+        // Too many presses, try to recover instead of abandoning the command
+        this->handle_reset_failure();
       } else {
         // LED3 not on yet, increment count and press select_cover again
-        this->select_cover_reset_press_count_++;
+        this->select_op_.reset_press_count++;
         ESP_LOGD(TAG, "Reset phase: Pressing select_cover (press #%u)", 
-                 this->select_cover_reset_press_count_);
-        this->press_button(this->select_cover_pin_, "Select Cover (Reset)", true);
-        this->select_cover_state_ = SELECT_COVER_RESETTING_TO_COVER3;
+                 this->select_op_.reset_press_count);
+        this->press_button(BUTTON_SELECT, "Select Cover (Reset)", true);
+        this->select_op_.state = SELECT_COVER_RESETTING_TO_COVER3;
       }
       break;
     }
       
     case SELECT_COVER_WAITING_FOR_BUTTON_RELEASE:
       // Wait for button to be released
-      if (this->active_button_pin_ == nullptr) {
+      if (this->active_buttons_ == 0) {
         // Button released, decrement presses remaining
-        this->select_cover_press_count_++;
+        this->select_op_.press_count++;
         
-        if (this->select_cover_presses_remaining_ > 0) {
-          this->select_cover_presses_remaining_--;
+        if (this->select_op_.presses_remaining > 0) {
+          this->select_op_.presses_remaining--;
         }
         
         ESP_LOGD(TAG, "Selection phase: Press completed, %u presses remaining", 
-                 this->select_cover_presses_remaining_);
+                 this->select_op_.presses_remaining);
         
-        if (this->select_cover_presses_remaining_ == 0) {
+        if (this->select_op_.presses_remaining == 0) {
           // All presses complete
           ESP_LOGI(TAG, "Select cover complete! Remote Cover %u (Index %u) reached after %u selection presses", 
-                   this->select_cover_target_ + 1, this->select_cover_target_, 
-                   this->select_cover_press_count_);
-          this->current_cover_index_ = this->select_cover_target_;
-          this->select_cover_state_ = SELECT_COVER_IDLE;
+                   this->select_op_.command.cover_index + 1, this->select_op_.command.cover_index, 
+                   this->select_op_.press_count);
+          this->current_cover_index_ = this->select_op_.command.cover_index;
+          this->select_op_.state = SELECT_COVER_IDLE;
           this->last_select_cover_complete_time_ = millis();
           
           // Execute pending action if any
-          if (this->pending_action_ == PENDING_ACTION_PRESS_UP) {
-            this->pending_action_ = PENDING_ACTION_NONE;
-            ESP_LOGI(TAG, "Executing pending action: Press UP for Remote Cover %u", this->select_cover_target_ + 1);
-            this->press_up();
-          } else if (this->pending_action_ == PENDING_ACTION_PRESS_DOWN) {
-            this->pending_action_ = PENDING_ACTION_NONE;
-            ESP_LOGI(TAG, "Executing pending action: Press DOWN for Remote Cover %u", this->select_cover_target_ + 1);
-            this->press_down();
-          } else if (this->pending_action_ == PENDING_ACTION_PRESS_MY) {
-            this->pending_action_ = PENDING_ACTION_NONE;
-            ESP_LOGI(TAG, "Executing pending action: Press MY for Remote Cover %u", this->select_cover_target_ + 1);
-            this->press_my();
-          }
+          this->execute_pending_action();
         } else {
           // Need more presses, wait a bit before next press
-          this->select_cover_state_ = SELECT_COVER_WAITING_FOR_NEXT_PRESS;
-          this->select_cover_wait_start_time_ = now;
+          this->select_op_.state = SELECT_COVER_WAITING_FOR_NEXT_PRESS;
+          this->select_op_.wait_start_time = now;
         }
       }
       break;
       
     case SELECT_COVER_WAITING_FOR_NEXT_PRESS: {
       // Wait before next press
-      uint32_t press_interval = this->button_press_duration_ms_ + SELECT_COVER_PRESS_MARGIN_MS;
-      if (now - this->select_cover_wait_start_time_ >= press_interval) {
+      uint32_t press_interval = this->get_press_duration_ms() + SELECT_COVER_PRESS_MARGIN_MS;
+      if (now - this->select_op_.wait_start_time >= press_interval && !this->stop_waiting()) {
         // Press select_cover again
-        this->press_button(this->select_cover_pin_, "Select Cover (Select)", true);
-        this->select_cover_state_ = SELECT_COVER_WAITING_FOR_BUTTON_RELEASE;
+        this->press_button(BUTTON_SELECT, "Select Cover (Select)", true);
+        this->select_op_.state = SELECT_COVER_WAITING_FOR_BUTTON_RELEASE;
       }
       break;
     }
@@ -564,12 +1059,17 @@ void PeshoSomfyComponent::handle_select_cover_state_machine() {
 
 bool PeshoSomfyComponent::is_ready() const {
   // Not ready if select cover operation is in progress
-  if (this->select_cover_state_ != SELECT_COVER_IDLE) {
+  if (this->select_op_.state != SELECT_COVER_IDLE) {
     return false;
   }
   
   // Not ready if a button is currently being pressed
-  if (this->active_button_pin_ != nullptr) {
+  if (this->active_buttons_ != 0) {
+    return false;
+  }
+  
+  // Not ready while commands wait for the gap after the last release
+  if (this->preempt_stop_mask_ != 0 || this->deferred_mask_ != 0) {
     return false;
   }
   
@@ -577,12 +1077,15 @@ bool PeshoSomfyComponent::is_ready() const {
 }
 
 const char* PeshoSomfyComponent::get_busy_reason() const {
-  if (this->select_cover_state_ != SELECT_COVER_IDLE) {
+  if (this->select_op_.state != SELECT_COVER_IDLE) {
     return "Select cover in progress";
   }
-  if (this->active_button_pin_ != nullptr) {
+  if (this->active_buttons_ != 0) {
     return "Button press in progress";
   }
+  if (this->preempt_stop_mask_ != 0 || this->deferred_mask_ != 0) {
+    return "Command queued";
+  }
   return "Ready";
 }
 
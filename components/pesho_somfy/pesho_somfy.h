@@ -1,38 +1,89 @@
 #pragma once
 
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
 #include "esphome/core/component.h"
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/components/binary_sensor/binary_sensor.h"
+#include "esphome/components/text_sensor/text_sensor.h"
 
 namespace esphome {
 namespace pesho_somfy {
 
+// Buttons on the remote
+enum RemoteButton : uint8_t {
+  BUTTON_SELECT,
+  BUTTON_UP,
+  BUTTON_DOWN,
+  BUTTON_MY,
+  NUM_BUTTONS
+};
+
+// Action executed after the cover is selected (see COVER_ACTION_TABLE)
+enum CoverAction : uint8_t {
+  COVER_ACTION_NONE,
+  COVER_ACTION_UP,
+  COVER_ACTION_DOWN,
+  COVER_ACTION_MY,
+  COVER_ACTION_HOLD_MY,    // Long press MY (store favourite position)
+  COVER_ACTION_UP_DOWN,    // UP+DOWN chord
+  COVER_ACTION_TILT_UP,    // Train of short UP pulses
+  COVER_ACTION_TILT_DOWN,  // Train of short DOWN pulses
+  COVER_ACTION_COUNT
+};
+
+// Compact cover command descriptor: which cover, and what to do once it's selected
+struct CoverCommand {
+  uint8_t cover_index;
+  CoverAction action;
+  uint8_t repeat;  // Pulses for pulse train actions (tilt steps), 1 otherwise
+};
+static_assert(sizeof(CoverCommand) == 3, "CoverCommand should stay compact");
+static_assert(std::is_trivially_copyable<CoverCommand>::value, "CoverCommand is copied around by value");
+
+// One button of a press pattern: press after start_delay_ms, hold for duration_ms
+struct ButtonPulse {
+  RemoteButton button;
+  uint32_t start_delay_ms;
+  uint32_t duration_ms;
+};
+
 class PeshoSomfyComponent : public Component {
  public:
   void setup() override;
   void loop() override;
   float get_setup_priority() const override { return setup_priority::HARDWARE; }
 
-  void set_select_cover_pin(InternalGPIOPin *pin) { select_cover_pin_ = pin; }
-  void set_up_pin(InternalGPIOPin *pin) { up_pin_ = pin; }
-  void set_down_pin(InternalGPIOPin *pin) { down_pin_ = pin; }
-  void set_my_pin(InternalGPIOPin *pin) { my_pin_ = pin; }
+  void set_select_cover_pin(InternalGPIOPin *pin) { button_pins_[BUTTON_SELECT] = pin; }
+  void set_up_pin(InternalGPIOPin *pin) { button_pins_[BUTTON_UP] = pin; }
+  void set_down_pin(InternalGPIOPin *pin) { button_pins_[BUTTON_DOWN] = pin; }
+  void set_my_pin(InternalGPIOPin *pin) { button_pins_[BUTTON_MY] = pin; }
   void set_led3_pin(InternalGPIOPin *pin) { led3_pin_ = pin; }
   void set_led4_pin(InternalGPIOPin *pin) { led4_pin_ = pin; }
   
   void set_button_press_duration(uint32_t duration_ms) { button_press_duration_ms_ = duration_ms; }
+  void set_long_press_duration(uint32_t duration_ms) { long_press_duration_ms_ = duration_ms; }
 
   // Binary sensor setters
   void set_led3_binary_sensor(binary_sensor::BinarySensor *sensor) { led3_binary_sensor_ = sensor; }
   void set_led4_binary_sensor(binary_sensor::BinarySensor *sensor) { led4_binary_sensor_ = sensor; }
   void set_ready_binary_sensor(binary_sensor::BinarySensor *sensor) { ready_binary_sensor_ = sensor; }
+  
+  // Text sensor setter
+  void set_status_text_sensor(text_sensor::TextSensor *sensor) { status_text_sensor_ = sensor; }
 
   void press_select_cover();
   void press_up();
   void press_down();
   void press_my();
+  
+  // Pulse engine: chords, long presses and pulse trains
+  void press_buttons(uint8_t button_mask, uint32_t duration_ms);  // Press buttons together (bit per RemoteButton)
+  void pulse_train(RemoteButton button, uint8_t count, uint32_t on_ms, uint32_t period_ms);  // N short pulses
+  void press_pattern(std::initializer_list<ButtonPulse> pulses);  // Own start offset and duration per button
 
   bool get_led3_state() const;
   bool get_led4_state() const;
@@ -51,20 +102,34 @@ class PeshoSomfyComponent : public Component {
   void cover_open(uint8_t cover_index);   // Select cover then press UP
   void cover_close(uint8_t cover_index);  // Select cover then press DOWN
   void cover_stop(uint8_t cover_index);   // Select cover then press MY
+  void cover_hold_my(uint8_t cover_index);  // Select cover then hold MY (store favourite position)
+  void cover_up_down(uint8_t cover_index);  // Select cover then press UP+DOWN together
+  void cover_tilt(uint8_t cover_index, bool up, uint8_t steps);  // Select cover then step tilt with short pulses
   
   // Operation state
   bool is_ready() const;  // Returns true if ready to accept new operations
   const char* get_busy_reason() const;  // Returns reason if busy, "Ready" if not
+  
+  // Degraded state (reset phase could not be recovered)
+  bool is_degraded() const { return degraded_; }
+  const char* get_degraded_reason() const { return degraded_reason_; }  // Empty if not degraded
+  void clear_degraded();  // Re-enable cover selection and forget learned fallbacks after fixing the cause
 
  protected:
-  void press_button(InternalGPIOPin *pin, const char *button_name, bool skip_ready_check = false);
-  void release_button_if_done();  // Non-blocking button release helper
+  void press_button(RemoteButton button, const char *button_name, bool skip_ready_check = false);
+  bool prepare_press(uint8_t button_mask, const char *button_name, bool skip_ready_check);  // Validate, track select
+  void start_press(uint8_t button_mask, const char *button_name, uint32_t on_ms, uint32_t period_ms, 
+                   uint8_t count, bool skip_ready_check);  // Press buttons together, optionally as a pulse train
+  void schedule_pulses(RemoteButton button, uint32_t start_delay_ms, uint32_t on_ms, uint32_t period_ms, 
+                       uint8_t count);  // Program one idle pulse channel (period already includes the gap)
+  void set_pin_pressed(InternalGPIOPin *pin);  // Safe LOW-then-OUTPUT press sequence
+  void update_pulse_engine();  // Non-blocking press/release of scheduled pulses
+  void truncate_pulse_trains();  // Stop pulse trains after the current pulse, cut long holds
   void handle_select_cover_state_machine();  // Handle select cover state machine
+  void press_action(CoverCommand command);  // Press the button(s) for an action (internal, skips ready check)
+  void execute_pending_action();  // Execute and clear the pending action of the select cover operation
 
-  InternalGPIOPin *select_cover_pin_;
-  InternalGPIOPin *up_pin_;
-  InternalGPIOPin *down_pin_;
-  InternalGPIOPin *my_pin_;
+  InternalGPIOPin *button_pins_[NUM_BUTTONS]{nullptr};  // Indexed by RemoteButton
   
   InternalGPIOPin *led3_pin_{nullptr};
   InternalGPIOPin *led4_pin_{nullptr};
@@ -72,19 +137,31 @@ class PeshoSomfyComponent : public Component {
   binary_sensor::BinarySensor *led3_binary_sensor_{nullptr};
   binary_sensor::BinarySensor *led4_binary_sensor_{nullptr};
   binary_sensor::BinarySensor *ready_binary_sensor_{nullptr};
+  text_sensor::TextSensor *status_text_sensor_{nullptr};
   
   uint32_t button_press_duration_ms_{500};
+  uint32_t long_press_duration_ms_{5000};  // HOLD MY (store favourite position)
   uint8_t current_cover_index_{3};  // Tracks currently selected cover (0-4), default 3
   
   // Development/debugging
   uint32_t last_cover_log_time_{0};  // Timestamp for periodic cover index logging
   bool last_ready_state_{true};  // Track previous ready state for change detection
   
-  // Non-blocking button press state machine
-  InternalGPIOPin *active_button_pin_{nullptr};  // Currently pressed button pin
-  const char *active_button_name_{nullptr};       // Name of currently pressed button
-  uint32_t button_press_start_time_{0};           // When button press started
+  // Non-blocking pulse engine, one channel per button
+  struct PulseChannel {
+    uint32_t start_time;       // When the current pulse starts
+    uint32_t on_ms;            // Pulse length
+    uint32_t period_ms;        // Start-to-start time between pulses of a train
+    uint8_t pulses_remaining;  // Pulses left including the current one, 0 = idle
+    bool pressed;              // Pin currently sinking current
+  };
+  PulseChannel pulse_channels_[NUM_BUTTONS]{};
+  uint8_t active_buttons_{0};                      // Bit per RemoteButton with pulses in progress
+  RemoteButton last_released_button_{BUTTON_SELECT};  // Button of the last finished press
+  uint32_t last_release_time_{0};                  // When the last press finished
+  HighFrequencyLoopRequester high_freq_loop_;      // Tight loop timing while pulses are active
   bool pending_cover_index_increment_{false};      // True if cover index should increment after release
+  static constexpr uint32_t MIN_PULSE_GAP_MS = 50;  // Minimum release time between pulses of a train
   
   // LED sync tracking
   uint32_t last_led_sync_time_{0};                  // Timestamp of last LED sync
@@ -104,9 +181,11 @@ class PeshoSomfyComponent : public Component {
   static constexpr uint32_t STABILITY_MARGIN_MS = 100;   // Safety margin
   static constexpr uint32_t LED_STABLE_DELAY_MS = LED_RESPONSE_TIME_MS + FILTER_DELAY_MS + STABILITY_MARGIN_MS;  // Total: 300ms
   static constexpr uint32_t MAX_RESET_PRESSES = 10;  // Maximum number of presses before giving up
+  static constexpr uint32_t RECOVERY_RESET_PRESSES = NUM_COVERS + 1;  // Presses per recovery attempt (full cycle + wake-up)
+  static constexpr uint8_t SLOW_TIMING_SCALE = 2;  // Press duration and LED stable delay multiplier for slow profile
   
   // Select cover state machine
-  enum SelectCoverState {
+  enum SelectCoverState : uint8_t {
     SELECT_COVER_IDLE,
     SELECT_COVER_RESETTING_TO_COVER3,      // Pressing until LED3 lights up
     SELECT_COVER_WAITING_FOR_LED3_STABLE,  // Waiting for LED3 to stabilize after press
@@ -114,22 +193,62 @@ class PeshoSomfyComponent : public Component {
     SELECT_COVER_WAITING_FOR_BUTTON_RELEASE, // Waiting for button release
     SELECT_COVER_WAITING_FOR_NEXT_PRESS     // Waiting before next press in selection phase
   };
-  SelectCoverState select_cover_state_{SELECT_COVER_IDLE};
-  uint32_t select_cover_wait_start_time_{0};
-  uint8_t select_cover_target_{0};
-  uint8_t select_cover_presses_remaining_{0};
-  uint8_t select_cover_press_count_{0};
-  uint8_t select_cover_reset_press_count_{0};  // Press count during reset phase
+  struct SelectCoverOperation {
+    CoverCommand command;       // Target cover, and pending action after select_cover completes
+    SelectCoverState state;
+    uint8_t presses_remaining;
+    uint8_t press_count;
+    uint8_t reset_press_count;  // Press count during reset phase
+    uint32_t wait_start_time;
+  };
+  SelectCoverOperation select_op_{{0, COVER_ACTION_NONE, 1}, SELECT_COVER_IDLE, 0, 0, 0, 0};
   static constexpr uint32_t SELECT_COVER_PRESS_MARGIN_MS = 50;  // Small margin after button_press_duration
   
-  // Pending action after select_cover completes
-  enum PendingAction {
-    PENDING_ACTION_NONE,
-    PENDING_ACTION_PRESS_UP,
-    PENDING_ACTION_PRESS_DOWN,
-    PENDING_ACTION_PRESS_MY
+  // Command scheduling: STOP (MY) preempts in-flight selections, other commands are deferred
+  void submit_cover_command(CoverCommand command);    // Queue or run a cover command
+  void dispatch_cover_command(CoverCommand command);  // Run a cover command now (device idle)
+  void start_select_cover(uint8_t target_cover_index);  // Start select cover state machine
+  void service_command_queue();  // Start preempting/deferred commands on a press boundary
+  void abort_select_cover();  // Abort in-flight selection for a STOP, re-planning it afterwards
+  void replan_interrupted_command(CoverCommand command);  // Defer a command cut off by a STOP, unless superseded
+  bool stop_in_flight() const { return this->select_op_.state != SELECT_COVER_IDLE && this->select_op_.command.action == COVER_ACTION_MY; }
+  bool stop_waiting() const { return this->preempt_stop_mask_ != 0 && !this->stop_in_flight(); }  // Selection should give way
+  
+  uint8_t next_queued_cover(uint8_t cover_mask) const;  // Cover to serve next from a per-cover mask
+  
+  uint8_t preempt_stop_mask_{0};                       // One bit per cover index with a STOP waiting to preempt
+  uint8_t deferred_mask_{0};                           // One bit per cover index with a deferred (or interrupted) command
+  CoverCommand deferred_commands_[NUM_COVERS]{};       // Commands waiting for the device to become idle, one per cover
+  CoverCommand active_command_{0, COVER_ACTION_NONE, 1};  // Action whose pulses are running (re-planned if cut)
+  bool cover_index_known_{true};                       // False after an aborted/failed reset phase until re-anchored
+  
+  // Reset phase recovery
+  enum RecoveryStage : uint8_t {
+    RECOVERY_NONE,         // Normal reset to Cover 3 (LED3 anchor)
+    RECOVERY_LED4_ANCHOR,  // Retry accepting LED4 (Cover 4) as anchor
+    RECOVERY_SLOW_TIMING   // Retry with slow timing profile
   };
-  PendingAction pending_action_{PENDING_ACTION_NONE};
+  uint8_t detect_anchor(bool led3_on, bool led4_on) const;  // Anchor cover index for LED states, NUM_COVERS if none
+  void start_reset_phase();  // (Re)start pressing select_cover until an anchor LED lights up
+  void record_reset_observation(bool led3_on, bool led4_on);  // Track LED activity during reset phase
+  const char *diagnose_reset_failure() const;  // Best guess why the reset phase failed
+  void handle_reset_failure();  // Next recovery step, or mark degraded
+  void set_degraded(const char *reason);
+  void publish_status();  // Publish OK/recovered/degraded status to text sensor if linked
+  uint32_t get_press_duration_ms() const { return this->button_press_duration_ms_ * this->timing_scale_; }
+  
+  RecoveryStage recovery_stage_{RECOVERY_NONE};
+  uint8_t timing_scale_{1};             // 1 = normal, SLOW_TIMING_SCALE during a slow retry or once it was needed
+  bool slow_timing_learned_{false};     // A reset succeeded with the slow profile, keep using it
+  bool led4_anchor_learned_{false};     // A reset succeeded with LED4 as anchor, accept it right away
+  const char *recovery_reason_{""};     // Diagnosis that made the learned fallbacks necessary
+  uint8_t reset_led_changes_{0};        // Filtered LED state changes seen during reset phase
+  uint8_t reset_last_led_state_{0};     // Last filtered LED state (bit 0 = LED3, bit 1 = LED4)
+  bool reset_led3_seen_{false};         // Filtered LED3 seen ON during reset phase
+  bool reset_led4_seen_{false};         // Filtered LED4 seen ON during reset phase
+  bool reset_raw_led3_seen_{false};     // Raw LED3 pin seen ON during reset phase
+  bool degraded_{false};
+  const char *degraded_reason_{""};
 };
 
 }  // namespace pesho_somfy